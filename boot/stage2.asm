@@ -48,6 +48,17 @@ KERNEL_LOAD_OFFSET equ 0x0000   ; Initially load to 0x10000
 KERNEL_SECTORS equ 64           ; Adjust based on your kernel size (32KB)
 KERNEL_PMODE_ADDR equ 0x100000  ; Final kernel address in protected mode (1MB)
 
+; Boot info handed to the kernel (see kernel/include/boot.h)
+BOOT_INFO equ 0x1000            ; struct boot_info
+BOOT_INFO_MAGIC equ 'HSSB'      ; Set once a VBE mode is active
+VBE_CTRL_INFO equ 0x1100        ; VbeInfoBlock (512 bytes)
+VBE_MODE_INFO equ 0x1300        ; ModeInfoBlock (256 bytes)
+
+; Requested graphics mode
+VBE_WIDTH equ 1024
+VBE_HEIGHT equ 768
+VBE_BPP equ 32
+
 s2_start:
     ; Set up segments and stack
     xor ax, ax
@@ -71,6 +82,9 @@ s2_start:
     ; Switch to protected mode
     mov si, protected_mode_msg
     call ps_16
+
+    ; Set a linear framebuffer mode (last, BIOS text output stops here)
+    call vbe_setup
     call switch_to_protected_mode
     
     ; We never return from switch_to_protected_mode
@@ -130,6 +144,82 @@ disk_error:
     hlt
     jmp $                      ; Infinite loop
 
+; === Set VBE linear framebuffer mode ===
+; Walks the BIOS mode list for VBE_WIDTH x VBE_HEIGHT x VBE_BPP with a linear,
+; direct color 0x00RRGGBB framebuffer and fills in BOOT_INFO. Leaves text mode alone if none is found.
+vbe_setup:
+    xor ax, ax
+    mov es, ax                 ; load_kernel left ES at the kernel segment
+    mov dword [BOOT_INFO], 0   ; No framebuffer unless we succeed
+
+    ; Get controller info (asking for VBE 2.0+ fields)
+    mov di, VBE_CTRL_INFO
+    mov dword [di], 'VBE2'
+    mov ax, 0x4F00
+    int 0x10
+    cmp ax, 0x004F
+    jne .done
+    cmp word [VBE_CTRL_INFO + 4], 0x0200 ; VbeVersion, LFB fields need 2.0+
+    jb .done
+
+    ; VBE 3.0 has separate pitch and color fields for linear modes
+    mov bp, VBE_MODE_INFO + 16 ; BytesPerScanLine
+    mov bx, VBE_MODE_INFO + 31 ; RedMaskSize .. BlueFieldPosition
+    cmp word [VBE_CTRL_INFO + 4], 0x0300
+    jb .find_mode
+    mov bp, VBE_MODE_INFO + 50 ; LinBytesPerScanLine
+    mov bx, VBE_MODE_INFO + 54 ; LinRedMaskSize .. LinBlueFieldPosition
+.find_mode:
+    lfs si, [VBE_CTRL_INFO + 14] ; FS:SI = VideoModePtr
+.next_mode:
+    mov cx, [fs:si]
+    add si, 2
+    cmp cx, 0xFFFF             ; End of mode list
+    je .done
+
+    ; Get mode info
+    mov ax, 0x4F01
+    mov di, VBE_MODE_INFO
+    int 0x10
+    cmp ax, 0x004F
+    jne .next_mode
+
+    cmp dword [VBE_MODE_INFO + 18], VBE_HEIGHT << 16 | VBE_WIDTH ; X/YResolution
+    jne .next_mode
+    cmp byte [VBE_MODE_INFO + 25], VBE_BPP    ; BitsPerPixel
+    jne .next_mode
+    mov al, [VBE_MODE_INFO]                   ; ModeAttributes
+    and al, 0x81                              ; Supported + linear framebuffer
+    cmp al, 0x81
+    jne .next_mode
+    cmp byte [VBE_MODE_INFO + 27], 6          ; MemoryModel: direct color
+    jne .next_mode
+
+    ; The kernel draws 0x00RRGGBB, want 8 bits each of red@16, green@8, blue@0
+    cmp dword [bx], 0x08081008
+    jne .next_mode
+    cmp word [bx + 4], 0x0008
+    jne .next_mode
+
+    ; Set the mode with the linear framebuffer bit
+    mov bx, cx
+    or bx, 0x4000
+    mov ax, 0x4F02
+    int 0x10
+    cmp ax, 0x004F
+    jne .done
+
+    ; Hand the framebuffer to the kernel
+    mov eax, [VBE_MODE_INFO + 40]  ; PhysBasePtr
+    mov [BOOT_INFO + 4], eax
+    mov ax, [bp]                   ; (Lin)BytesPerScanLine, SS is 0 like DS
+    mov [BOOT_INFO + 8], ax
+    mov dword [BOOT_INFO + 10], VBE_HEIGHT << 16 | VBE_WIDTH ; The mode we matched
+    mov byte [BOOT_INFO + 14], VBE_BPP
+    mov dword [BOOT_INFO], BOOT_INFO_MAGIC
+.done:
+    ret
+
 ; === Switch to protected mode ===
 switch_to_protected_mode:
     cli                        ; Disable interrupts
@@ -168,4 +258,7 @@ protected_mode_entry:
     
     ; Jump to kernel entry point (0x100000 as specified in linker.ld)
     ; Our start function is now at exactly this address due to linker script changes
-    jmp KERNEL_PMODE_ADDR
\ No newline at end of file
+    jmp KERNEL_PMODE_ADDR
+
+; Stage1 loads a single sector of stage2, fail the build if we outgrow it
+times 512-($-$$) db 0
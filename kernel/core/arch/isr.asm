@@ -35,6 +35,7 @@ global isr28
 global isr29
 global isr30
 global isr31
+global isr48
 
 ; External function that will handle all interrupts
 extern isr_handler
@@ -101,6 +102,9 @@ ISR_NOERRCODE 29 ; Reserved
 ISR_NOERRCODE 30 ; Reserved
 ISR_NOERRCODE 31 ; Reserved
 
+; Define ISRs for software interrupts
+ISR_NOERRCODE 48 ; IPC wait/notify
+
 ; Common ISR handler code
 isr_common_stub:
     pusha           ; Push all registers (EAX, ECX, EDX, EBX, ESP, EBP, ESI, EDI)
@@ -0,0 +1,77 @@
+; kernel/core/arch/multiboot.asm - Multiboot header and entry shim
+[bits 32]
+
+global kernel_entry
+global mb_entry
+
+extern start
+extern multiboot_init
+extern stack_top
+
+; Multiboot header flags
+MB_HEADER_MAGIC equ 0x1BADB002
+MB_PAGE_ALIGN   equ 1 << 0      ; Load modules on page boundaries
+MB_MEMORY_INFO  equ 1 << 1      ; Provide mem_* and the memory map
+MB_VIDEO_MODE   equ 1 << 2      ; Ask the loader for a graphics mode
+MB_HEADER_FLAGS equ MB_PAGE_ALIGN | MB_MEMORY_INFO | MB_VIDEO_MODE
+MB_CHECKSUM     equ -(MB_HEADER_MAGIC + MB_HEADER_FLAGS)
+
+section .text.entry progbits alloc exec nowrite align=16
+
+; Stage2 jumps to the very first byte of the kernel (0x100000)
+kernel_entry:
+    jmp start
+
+; The header only has to be in the first 8KB of the image, 4-byte aligned
+align 4
+multiboot_header:
+    dd MB_HEADER_MAGIC
+    dd MB_HEADER_FLAGS
+    dd MB_CHECKSUM
+    dd 0, 0, 0, 0, 0    ; Address fields, unused for ELF images
+    dd 0                ; Linear graphics mode, a preference the loader may ignore
+    dd 1024             ; Width
+    dd 768              ; Height
+    dd 32               ; Depth (multiboot_init drops anything but 32bpp RGB)
+
+; Multiboot loaders (GRUB, qemu -kernel) enter here with
+; EAX = 0x2BADB002 and EBX = physical address of the multiboot info
+mb_entry:
+    cli
+    mov esp, stack_top
+
+    ; The loader's GDT is undefined, load ours so 0x08/0x10 match stage2
+    lgdt [mb_gdt_descriptor]
+    jmp 0x08:.reload_cs
+.reload_cs:
+    mov cx, 0x10
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+    mov ss, cx
+
+    ; Copy out what we need from the multiboot info before anything reuses it.
+    ; stack_top is 16-byte aligned, pad so ESP still is at the call.
+    sub esp, 8
+    push ebx
+    push eax
+    call multiboot_init
+
+    ; Enter start() as if it was called: aligned stack plus a return slot
+    add esp, 12
+    jmp start
+
+section .data
+
+; Same flat layout as stage2: null, code (0x08), data (0x10)
+align 8
+mb_gdt:
+    dq 0x0000000000000000
+    dq 0x00CF9A000000FFFF
+    dq 0x00CF92000000FFFF
+mb_gdt_end:
+
+mb_gdt_descriptor:
+    dw mb_gdt_end - mb_gdt - 1
+    dd mb_gdt
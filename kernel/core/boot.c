@@ -0,0 +1,190 @@
+// boot.c - Boot information from stage2 or a Multiboot loader
+
+#include "../include/kernel.h"
+
+int boot_multiboot;
+uint32_t boot_mem_lower;
+uint32_t boot_mem_upper;
+char boot_cmdline[BOOT_CMDLINE_MAX];
+struct boot_mmap_entry boot_mmap[BOOT_MMAP_MAX];
+int boot_mmap_count;
+struct boot_module boot_modules[BOOT_MODULES_MAX];
+int boot_modules_count;
+uint32_t boot_modules_end;
+
+// First free page after the kernel image, defined in linker.ld
+extern char kernel_end[];
+
+// Next address boot_reserve hands out, 0 until first use
+static uint32_t boot_reserve_next;
+
+// Copy a NUL-terminated string, truncating to fit
+static void boot_copy_string(char *dst, const char *src, int max) {
+    int i = 0;
+    if (src) {
+        for (; i < max - 1 && src[i] != '\0'; i++) {
+            dst[i] = src[i];
+        }
+    }
+    dst[i] = '\0';
+}
+
+void multiboot_init(uint32_t magic, struct multiboot_info *mbi) {
+    if (magic != MULTIBOOT_BOOTLOADER_MAGIC) {
+        return;
+    }
+    boot_multiboot = 1;
+
+    if (mbi->flags & MULTIBOOT_INFO_MEMORY) {
+        boot_mem_lower = mbi->mem_lower;
+        boot_mem_upper = mbi->mem_upper;
+    }
+
+    if (mbi->flags & MULTIBOOT_INFO_CMDLINE) {
+        boot_copy_string(boot_cmdline, (const char *)mbi->cmdline, BOOT_CMDLINE_MAX);
+    }
+
+    if (mbi->flags & MULTIBOOT_INFO_MEM_MAP) {
+        uint32_t addr = mbi->mmap_addr;
+        uint32_t end = mbi->mmap_addr + mbi->mmap_length;
+
+        while (addr < end && boot_mmap_count < BOOT_MMAP_MAX) {
+            struct multiboot_mmap_entry *entry = (struct multiboot_mmap_entry *)addr;
+            boot_mmap[boot_mmap_count].addr = entry->addr;
+            boot_mmap[boot_mmap_count].len = entry->len;
+            boot_mmap[boot_mmap_count].type = entry->type;
+            boot_mmap_count++;
+
+            // Entries are variable sized, size does not count itself
+            addr += entry->size + 4;
+        }
+    }
+
+    if (mbi->flags & MULTIBOOT_INFO_MODS) {
+        struct multiboot_module *mods = (struct multiboot_module *)mbi->mods_addr;
+
+        for (uint32_t i = 0; i < mbi->mods_count && boot_modules_count < BOOT_MODULES_MAX; i++) {
+            struct boot_module *mod = &boot_modules[boot_modules_count++];
+            mod->start = mods[i].mod_start;
+            mod->end = mods[i].mod_end;
+            boot_copy_string(mod->name, (const char *)mods[i].string, BOOT_NAME_MAX);
+
+            if (mod->end > boot_modules_end) {
+                boot_modules_end = mod->end;
+            }
+        }
+    }
+
+    // Read the framebuffer fields before touching boot_info, the loader's
+    // structures may live at that address. Only a 32bpp RGB framebuffer
+    // the console can draw on (and whose pitch fits boot_info) is kept.
+    int fb_ok = (mbi->flags & MULTIBOOT_INFO_FRAMEBUFFER) &&
+                mbi->framebuffer_type == MULTIBOOT_FRAMEBUFFER_RGB &&
+                mbi->framebuffer_bpp == 32 &&
+                (mbi->framebuffer_addr >> 32) == 0 &&
+                mbi->framebuffer_pitch <= 0xFFFF &&
+                mbi->framebuffer_width <= 0xFFFF &&
+                mbi->framebuffer_height <= 0xFFFF;
+    uint32_t fb_addr = (uint32_t)mbi->framebuffer_addr;
+    uint32_t fb_pitch = mbi->framebuffer_pitch;
+    uint32_t fb_width = mbi->framebuffer_width;
+    uint32_t fb_height = mbi->framebuffer_height;
+
+    volatile struct boot_info *info = (volatile struct boot_info *)BOOT_INFO_ADDR;
+    info->magic = 0;
+    if (fb_ok) {
+        info->fb_addr = fb_addr;
+        info->fb_pitch = fb_pitch;
+        info->fb_width = fb_width;
+        info->fb_height = fb_height;
+        info->fb_bpp = 32;
+        info->magic = BOOT_INFO_MAGIC;
+    }
+}
+
+// Check that [start, end) lies inside one available memory map entry
+static int boot_range_available(uint32_t start, uint32_t end) {
+    if (boot_mmap_count == 0) {
+        return 1;
+    }
+
+    for (int i = 0; i < boot_mmap_count; i++) {
+        if (boot_mmap[i].type == MULTIBOOT_MEMORY_AVAILABLE &&
+            boot_mmap[i].addr <= start &&
+            boot_mmap[i].addr + boot_mmap[i].len >= end) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t boot_reserve(uint32_t size) {
+    if (boot_reserve_next == 0) {
+        // Multiboot loaders put modules right after the kernel, start past them
+        boot_reserve_next = (uint32_t)kernel_end;
+        if (boot_modules_end > boot_reserve_next) {
+            boot_reserve_next = (boot_modules_end + 0xFFF) & ~0xFFF;
+        }
+    }
+
+    uint32_t start = boot_reserve_next;
+    uint32_t end = start + ((size + 0xFFF) & ~0xFFF);
+    if (end < start || !boot_range_available(start, end)) {
+        return 0;
+    }
+
+    boot_reserve_next = end;
+    return start;
+}
+
+int boot_cmdline_has(const char *option) {
+    const char *p = boot_cmdline;
+
+    while (*p) {
+        // Skip separators
+        while (*p == ' ') {
+            p++;
+        }
+
+        // Compare the option against the start of this token
+        int i = 0;
+        while (option[i] != '\0' && p[i] == option[i]) {
+            i++;
+        }
+        if (option[i] == '\0' && (p[i] == '\0' || p[i] == ' ' || p[i] == '=')) {
+            return 1;
+        }
+
+        // Move on to the next token
+        while (*p && *p != ' ') {
+            p++;
+        }
+    }
+
+    return 0;
+}
+
+void boot_print_info() {
+    if (!boot_multiboot) {
+        serial_printf("Booted from floppy (stage2)\r\n");
+        return;
+    }
+
+    serial_printf("Booted via Multiboot\r\n");
+    serial_printf("  Command line: %s\r\n", boot_cmdline);
+    serial_printf("  Memory: %d KB lower, %d KB upper\r\n", boot_mem_lower, boot_mem_upper);
+
+    for (int i = 0; i < boot_mmap_count; i++) {
+        // Everything we can address without PAE fits in the low 32 bits
+        serial_printf("  mmap: 0x%x - 0x%x %s\r\n",
+                      (uint32_t)boot_mmap[i].addr,
+                      (uint32_t)(boot_mmap[i].addr + boot_mmap[i].len),
+                      boot_mmap[i].type == MULTIBOOT_MEMORY_AVAILABLE ? "available" : "reserved");
+    }
+
+    for (int i = 0; i < boot_modules_count; i++) {
+        serial_printf("  module: 0x%x - 0x%x %s\r\n",
+                      boot_modules[i].start, boot_modules[i].end, boot_modules[i].name);
+    }
+}
@@ -0,0 +1,308 @@
+// fb.c - VBE linear framebuffer console
+
+#include "../include/kernel.h"
+
+// Four 32bpp pixels, lets GCC emit SSE2 loads/stores in sse2 functions
+typedef uint32_t fb_vec __attribute__((vector_size(16)));
+
+// Standard VGA text palette as 0x00RRGGBB
+static const uint32_t fb_palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA,
+    0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF,
+    0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF,
+};
+
+static uint8_t *fb_lfb;              // Linear framebuffer set up by stage2
+static uint32_t *fb_back;            // Back buffer in RAM
+static uint32_t fb_pitch;            // Framebuffer bytes per scanline
+static uint32_t fb_stride;           // Back buffer pixels per scanline
+static int fb_cols, fb_rows;         // Console size in text cells
+static int fb_cursor_x, fb_cursor_y; // fb_write position
+static int fb_log_top;               // First row of the scrolling log region
+static int fb_scroll_pending;        // Log rows the framebuffer still has to move up
+static int fb_use_sse2;              // Blit with SSE2 instead of plain stores
+static int fb_enabled;
+
+// Damaged cells per text row, [x0, x1) in columns, empty when x0 >= x1
+static uint16_t fb_dirty_x0[FB_MAX_ROWS];
+static uint16_t fb_dirty_x1[FB_MAX_ROWS];
+
+// Expands one font row (8 bits) into 8 pixel masks of all ones or zeros.
+// 8KB, reserved at init so it does not take up room in kernel.bin (.bss is
+// written out as zeros and stage2 only loads 32KB).
+static uint32_t (*fb_expand)[FONT_WIDTH];
+
+// Check CPUID for SSE2 support
+static int fb_cpu_has_sse2() {
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx >> 26) & 1;
+}
+
+// Let the CPU execute SSE instructions (CR0.EM off, CR0.MP, CR4.OSFXSR/OSXMMEXCPT on)
+static void fb_enable_sse() {
+    uint32_t cr0, cr4;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 = (cr0 & ~(1 << 2)) | (1 << 1);
+    __asm__ volatile("mov %0, %%cr0" : : "r"(cr0));
+    __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1 << 9) | (1 << 10);
+    __asm__ volatile("mov %0, %%cr4" : : "r"(cr4));
+}
+
+static inline void fb_copy_dwords(void *dst, const void *src, uint32_t count) {
+    __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(count) : : "memory");
+}
+
+static inline void fb_fill_dwords(void *dst, uint32_t value, uint32_t count) {
+    __asm__ volatile("rep stosl" : "+D"(dst), "+c"(count) : "a"(value) : "memory");
+}
+
+static void fb_mark_dirty(int row, int x0, int x1) {
+    if (fb_dirty_x0[row] >= fb_dirty_x1[row]) {
+        fb_dirty_x0[row] = x0;
+        fb_dirty_x1[row] = x1;
+        return;
+    }
+    if (x0 < fb_dirty_x0[row]) {
+        fb_dirty_x0[row] = x0;
+    }
+    if (x1 > fb_dirty_x1[row]) {
+        fb_dirty_x1[row] = x1;
+    }
+}
+
+static void fb_mark_rows_dirty(int first) {
+    for (int row = first; row < fb_rows; row++) {
+        fb_dirty_x0[row] = 0;
+        fb_dirty_x1[row] = fb_cols;
+    }
+}
+
+static void fb_glyph_scalar(uint32_t *dst, const uint8_t *glyph, uint32_t fg, uint32_t bg) {
+    for (int y = 0; y < FONT_HEIGHT; y++) {
+        const uint32_t *mask = fb_expand[glyph[y]];
+        for (int x = 0; x < FONT_WIDTH; x++) {
+            dst[x] = (fg & mask[x]) | (bg & ~mask[x]);
+        }
+        dst += fb_stride;
+    }
+}
+
+// One glyph row is 32 bytes: two aligned 16-byte select-and-store operations
+__attribute__((target("sse2")))
+static void fb_glyph_sse2(uint32_t *dst, const uint8_t *glyph, uint32_t fg, uint32_t bg) {
+    fb_vec vfg = { fg, fg, fg, fg };
+    fb_vec vbg = { bg, bg, bg, bg };
+
+    for (int y = 0; y < FONT_HEIGHT; y++) {
+        const fb_vec *mask = (const fb_vec *)fb_expand[glyph[y]];
+        fb_vec *out = (fb_vec *)dst;
+        out[0] = (vfg & mask[0]) | (vbg & ~mask[0]);
+        out[1] = (vfg & mask[1]) | (vbg & ~mask[1]);
+        dst += fb_stride;
+    }
+}
+
+// Copy whole cells (multiples of 8 pixels) from the back buffer to the framebuffer
+__attribute__((target("sse2")))
+static void fb_copy_sse2(uint8_t *dst, const uint32_t *src, uint32_t pixels) {
+    fb_vec *out = (fb_vec *)dst;
+    const fb_vec *in = (const fb_vec *)src;
+
+    for (uint32_t i = 0; i < pixels / 4; i += 2) {
+        out[i] = in[i];
+        out[i + 1] = in[i + 1];
+    }
+}
+
+static void fb_draw_char(int col, int row, char c, int color) {
+    uint32_t fg = fb_palette[color & 0x0F];
+    uint32_t bg = fb_palette[(color >> 4) & 0x0F];
+    uint32_t *dst = fb_back + row * FONT_HEIGHT * fb_stride + col * FONT_WIDTH;
+
+    if (c < FONT_FIRST || c > FONT_LAST) {
+        c = '?';
+    }
+    const uint8_t *glyph = font8x8[c - FONT_FIRST];
+
+    if (fb_use_sse2) {
+        fb_glyph_sse2(dst, glyph, fg, bg);
+    } else {
+        fb_glyph_scalar(dst, glyph, fg, bg);
+    }
+}
+
+void fb_init() {
+    struct boot_info *info = (struct boot_info *)BOOT_INFO_ADDR;
+
+    if (info->magic != BOOT_INFO_MAGIC || info->fb_bpp != 32) {
+        serial_printf("Framebuffer: no 32bpp VBE mode, using VGA text\r\n");
+        return;
+    }
+
+    fb_cols = info->fb_width / FONT_WIDTH;
+    fb_rows = info->fb_height / FONT_HEIGHT;
+    if (fb_rows > FB_MAX_ROWS) {
+        fb_rows = FB_MAX_ROWS;
+    }
+    fb_stride = fb_cols * FONT_WIDTH;
+
+    // The back buffer and expansion table go above the kernel and any
+    // Multiboot modules (page aligned, as the SSE2 path needs)
+    fb_back = (uint32_t *)boot_reserve(fb_stride * fb_rows * FONT_HEIGHT * 4);
+    fb_expand = (uint32_t (*)[FONT_WIDTH])boot_reserve(256 * FONT_WIDTH * 4);
+    if (!fb_back || !fb_expand) {
+        serial_printf("Framebuffer: no free RAM for a %dx%d back buffer\r\n",
+                      info->fb_width, info->fb_height);
+        return;
+    }
+
+    fb_lfb = (uint8_t *)info->fb_addr;
+    fb_pitch = info->fb_pitch;
+
+    // Precompute the 8-pixel expansion table
+    for (int bits = 0; bits < 256; bits++) {
+        for (int x = 0; x < FONT_WIDTH; x++) {
+            fb_expand[bits][x] = (bits & (0x80 >> x)) ? 0xFFFFFFFF : 0;
+        }
+    }
+
+    // SSE2 stores need 16-byte aligned framebuffer scanlines
+    if (fb_cpu_has_sse2() && (((uint32_t)fb_lfb | fb_pitch) & 15) == 0) {
+        fb_enable_sse();
+        fb_use_sse2 = 1;
+    }
+
+    // Rows above the log region stay put for kps/kprintf status lines
+    fb_log_top = fb_rows > FB_STATUS_ROWS ? FB_STATUS_ROWS : 0;
+
+    fb_enabled = 1;
+    fb_clear(0x00);
+    fb_flush();
+
+    serial_printf("Framebuffer console: %dx%d at 0x%x, %d x %d cells, %s blits\r\n",
+                  info->fb_width, info->fb_height, info->fb_addr, fb_cols, fb_rows,
+                  fb_use_sse2 ? "SSE2" : "scalar");
+}
+
+int fb_active() {
+    return fb_enabled;
+}
+
+void fb_puts(const char *str, int x, int y, int color) {
+    if (y < 0 || y >= fb_rows || x < 0) {
+        return;
+    }
+
+    int col = x;
+    for (int i = 0; str[i] != '\0' && col < fb_cols; i++, col++) {
+        fb_draw_char(col, y, str[i], color);
+    }
+
+    if (col > x) {
+        fb_mark_dirty(y, x, col);
+    }
+}
+
+void fb_write(const char *str, int color) {
+    for (int i = 0; str[i] != '\0'; i++) {
+        if (str[i] == '\n' || fb_cursor_x >= fb_cols) {
+            fb_cursor_x = 0;
+            fb_cursor_y++;
+        }
+        if (fb_cursor_y >= fb_rows) {
+            fb_scroll(fb_cursor_y - fb_rows + 1, color);
+            fb_cursor_y = fb_rows - 1;
+        }
+        if (str[i] == '\n' || str[i] == '\r') {
+            continue;
+        }
+
+        fb_draw_char(fb_cursor_x, fb_cursor_y, str[i], color);
+        fb_mark_dirty(fb_cursor_y, fb_cursor_x, fb_cursor_x + 1);
+        fb_cursor_x++;
+    }
+
+    fb_flush();
+}
+
+void fb_scroll(int lines, int color) {
+    int region = fb_rows - fb_log_top;
+    if (lines <= 0) {
+        return;
+    }
+    if (lines > region) {
+        lines = region;
+    }
+
+    uint32_t row_pixels = fb_stride * FONT_HEIGHT;
+    uint32_t *top = fb_back + fb_log_top * row_pixels;
+    uint32_t keep = (region - lines) * row_pixels;
+
+    // Block move the surviving rows up, then clear the uncovered ones
+    fb_copy_dwords(top, top + lines * row_pixels, keep);
+    fb_fill_dwords(top + keep, fb_palette[(color >> 4) & 0x0F], lines * row_pixels);
+
+    // fb_flush repeats the move on the framebuffer, so pending damage
+    // moves with its rows and only the uncovered rows need redrawing
+    fb_scroll_pending += lines;
+    if (fb_scroll_pending >= region) {
+        fb_scroll_pending = 0;
+        fb_mark_rows_dirty(fb_log_top);
+        return;
+    }
+
+    for (int row = fb_log_top; row < fb_rows - lines; row++) {
+        fb_dirty_x0[row] = fb_dirty_x0[row + lines];
+        fb_dirty_x1[row] = fb_dirty_x1[row + lines];
+    }
+    fb_mark_rows_dirty(fb_rows - lines);
+}
+
+void fb_clear(unsigned char color) {
+    fb_fill_dwords(fb_back, fb_palette[(color >> 4) & 0x0F],
+                   fb_stride * fb_rows * FONT_HEIGHT);
+
+    fb_cursor_x = 0;
+    fb_cursor_y = fb_log_top;
+    fb_scroll_pending = 0;
+    fb_mark_rows_dirty(0);
+}
+
+void fb_flush() {
+    // Apply pending scrolls as one block move inside the framebuffer
+    if (fb_scroll_pending) {
+        uint32_t row_bytes = fb_pitch * FONT_HEIGHT;
+        uint8_t *top = fb_lfb + fb_log_top * row_bytes;
+        uint32_t keep = (fb_rows - fb_log_top - fb_scroll_pending) * row_bytes;
+
+        fb_copy_dwords(top, top + fb_scroll_pending * row_bytes, keep / 4);
+        fb_scroll_pending = 0;
+    }
+
+    for (int row = 0; row < fb_rows; row++) {
+        int x0 = fb_dirty_x0[row];
+        int x1 = fb_dirty_x1[row];
+        if (x0 >= x1) {
+            continue;
+        }
+
+        uint32_t pixels = (x1 - x0) * FONT_WIDTH;
+        for (int line = 0; line < FONT_HEIGHT; line++) {
+            uint32_t y = row * FONT_HEIGHT + line;
+            const uint32_t *src = fb_back + y * fb_stride + x0 * FONT_WIDTH;
+            uint8_t *dst = fb_lfb + y * fb_pitch + x0 * FONT_WIDTH * 4;
+
+            if (fb_use_sse2) {
+                fb_copy_sse2(dst, src, pixels);
+            } else {
+                fb_copy_dwords(dst, src, pixels);
+            }
+        }
+
+        fb_dirty_x0[row] = 0;
+        fb_dirty_x1[row] = 0;
+    }
+}
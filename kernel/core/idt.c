@@ -102,6 +102,12 @@ const char *exception_messages[] = {
 
 // This function is called from the ASM interrupt handler
 void isr_handler(struct registers *regs) {
+    // IPC traps are part of normal operation, keep them off the consoles
+    if (regs->int_no == IPC_VECTOR) {
+        ipc_handler(regs);
+        return;
+    }
+
     // Handle the interrupt
     serial_printf("Received interrupt: %d, Error code: %d\r\n", regs->int_no, regs->err_code);
     
@@ -1,6 +1,6 @@
 // io.c - I/O functions
 
-#include "../include/io.h"
+#include "../include/kernel.h"
 
 // Define a simple implementation for variable arguments
 typedef __builtin_va_list va_list;
@@ -11,6 +11,13 @@ typedef __builtin_va_list va_list;
 // Serial port functions are using COM1 defined in the header
 
 void kps(const char *str, int x, int y, int color) {
+    // Draw on the framebuffer console when stage2 set a graphics mode
+    if (fb_active()) {
+        fb_puts(str, x, y, color);
+        fb_flush();
+        return;
+    }
+
     // VGA buffer address
     volatile unsigned short *vga_buffer = (volatile unsigned short *)0xB8000;
 
@@ -25,6 +32,12 @@ void kps(const char *str, int x, int y, int color) {
 }
 
 void vga_clear(unsigned char color) {
+    if (fb_active()) {
+        fb_clear(color);
+        fb_flush();
+        return;
+    }
+
     // VGA buffer address
     volatile unsigned short *vga_buffer = (volatile unsigned short *)0xB8000;
 
@@ -51,11 +64,12 @@ void itoa(int num, char *str, int base) {
         num = -num;
     }
 
-    // Process individual digits
-    while (num != 0) {
-        int remainder = num % base;
+    // Process individual digits (other bases print the raw bits, e.g. addresses above 2GB)
+    unsigned int value = (unsigned int)num;
+    while (value != 0) {
+        int remainder = value % base;
         str[i++] = (remainder > 9) ? (remainder - 10) + 'A' : remainder + '0';
-        num /= base;
+        value /= base;
     }
 
     // If the number is negative, append '-'
@@ -271,6 +285,11 @@ int serial_printf(const char *format, ...) {
     
     // Send the buffer to serial port
     serial_send_string(buffer);
+
+    // Mirror the kernel log into the framebuffer console's scrolling region
+    if (fb_active()) {
+        fb_write(buffer, 0x07);
+    }
     
     va_end(args);
     return chars_printed;
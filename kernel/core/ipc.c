@@ -0,0 +1,265 @@
+// ipc.c - Shared-memory message passing
+
+#include "../include/kernel.h"
+
+// Bump allocator over the shared page pool
+static uint32_t ipc_pool_next;
+static uint32_t ipc_pool_end;
+
+// Allocate one zeroed, page-aligned shared page
+static void *ipc_page_alloc() {
+    if (ipc_pool_next >= ipc_pool_end) {
+        return 0;
+    }
+
+    uint32_t *page = (uint32_t *)ipc_pool_next;
+    ipc_pool_next += IPC_PAGE_SIZE;
+
+    for (int i = 0; i < IPC_PAGE_SIZE / 4; i++) {
+        page[i] = 0;
+    }
+
+    return page;
+}
+
+// Copy a payload a byte at a time (we have no libc memcpy)
+static void ipc_copy(uint8_t *dst, const uint8_t *src, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = src[i];
+    }
+}
+
+// Trap into the kernel with an IPC operation, the result comes back in EAX
+static inline int ipc_syscall(uint32_t op, struct ipc_ring *ring) {
+    __asm__ volatile("int %1" : "+a"(op) : "i"(IPC_VECTOR), "b"(ring) : "memory");
+    return (int)op;
+}
+
+// A ring is empty when the slot at tail has not been published yet
+static int ipc_ring_empty(struct ipc_ring *ring) {
+    uint32_t pos = ring->tail;
+    struct ipc_slot *slot = &ring->slots[pos & (IPC_RING_SLOTS - 1)];
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1;
+}
+
+// A ring is full when the slot at head has not been released by the consumer
+static int ipc_ring_full(struct ipc_ring *ring) {
+    uint32_t pos = ring->head;
+    struct ipc_slot *slot = &ring->slots[pos & (IPC_RING_SLOTS - 1)];
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos;
+}
+
+static void ipc_ring_init(struct ipc_ring *ring, struct ipc_slot *slots, int mode) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mode = mode;
+    ring->slots = slots;
+
+    // Slot i is free for the producer whose position is i
+    for (int i = 0; i < IPC_RING_SLOTS; i++) {
+        slots[i].seq = i;
+    }
+}
+
+void ipc_init() {
+    // The pool sits above the kernel, modules and back buffer (no paging
+    // yet, so pages are shared by handing both endpoints the same address)
+    ipc_pool_next = boot_reserve(IPC_POOL_PAGES * IPC_PAGE_SIZE);
+    ipc_pool_end = ipc_pool_next ? ipc_pool_next + IPC_POOL_PAGES * IPC_PAGE_SIZE : 0;
+
+    idt_set_gate(IPC_VECTOR, (uint32_t)isr48, 0x08, 0x8E); // IPC wait/notify
+
+    if (!ipc_pool_next) {
+        serial_printf("IPC initialized: no free RAM for shared pages\r\n");
+        return;
+    }
+
+    serial_printf("IPC initialized: %d shared pages at 0x%x\r\n", IPC_POOL_PAGES, ipc_pool_next);
+}
+
+int ipc_channel_create(struct ipc_channel *chan, int mode) {
+    if (mode != IPC_MODE_SPSC && mode != IPC_MODE_MPSC) {
+        return IPC_EINVAL;
+    }
+
+    // Control page holds both ring headers, then one data page per direction
+    struct ipc_ring *rings = ipc_page_alloc();
+    struct ipc_slot *a_to_b = ipc_page_alloc();
+    struct ipc_slot *b_to_a = ipc_page_alloc();
+    if (!rings || !a_to_b || !b_to_a) {
+        return IPC_ENOMEM;
+    }
+
+    ipc_ring_init(&rings[0], a_to_b, mode);
+    ipc_ring_init(&rings[1], b_to_a, mode);
+
+    chan->a.tx = &rings[0];
+    chan->a.rx = &rings[1];
+    chan->b.tx = &rings[1];
+    chan->b.rx = &rings[0];
+
+    return IPC_OK;
+}
+
+int ipc_send(struct ipc_endpoint *ep, uint32_t type, const void *data, uint32_t len) {
+    struct ipc_ring *ring = ep->tx;
+    struct ipc_slot *slot;
+
+    if (len > IPC_MSG_MAX) {
+        return IPC_EINVAL;
+    }
+
+    // Claim a slot. A slot is ours when its sequence equals our position.
+    uint32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    for (;;) {
+        slot = &ring->slots[pos & (IPC_RING_SLOTS - 1)];
+        int diff = (int)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff < 0) {
+            return IPC_EFULL;
+        }
+
+        if (diff > 0) {
+            // Another producer got here first
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (ring->mode == IPC_MODE_SPSC) {
+            // Nobody else writes head, a plain store is enough
+            __atomic_store_n(&ring->head, pos + 1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    // Fill the slot and publish it to the consumer
+    slot->type = type;
+    slot->len = len;
+    ipc_copy(slot->data, data, len);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    // Only enter the kernel if the consumer went to sleep on an empty ring
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (ring->consumers_waiting) {
+        ipc_syscall(IPC_OP_NOTIFY_RECV, ring);
+    }
+
+    return IPC_OK;
+}
+
+int ipc_recv(struct ipc_endpoint *ep, struct ipc_msg *msg) {
+    struct ipc_ring *ring = ep->rx;
+    uint32_t pos = ring->tail;
+    struct ipc_slot *slot = &ring->slots[pos & (IPC_RING_SLOTS - 1)];
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+        return IPC_EEMPTY;
+    }
+
+    // The slot lives in a page the sender can write, read the length once
+    // and never trust it beyond our own buffer
+    uint32_t len = slot->len;
+    int ret = IPC_OK;
+    if (len > IPC_MSG_MAX) {
+        ret = IPC_EINVAL;
+    } else {
+        msg->type = slot->type;
+        msg->len = len;
+        ipc_copy(msg->data, slot->data, len);
+    }
+
+    // Hand the slot back to producers one lap ahead (even if we dropped it)
+    __atomic_store_n(&slot->seq, pos + IPC_RING_SLOTS, __ATOMIC_RELEASE);
+    ring->tail = pos + 1;
+
+    // Only enter the kernel if a producer went to sleep on a full ring
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (ring->producers_waiting) {
+        ipc_syscall(IPC_OP_NOTIFY_SEND, ring);
+    }
+
+    return ret;
+}
+
+int ipc_send_wait(struct ipc_endpoint *ep, uint32_t type, const void *data, uint32_t len) {
+    struct ipc_ring *ring = ep->tx;
+
+    for (;;) {
+        int ret = ipc_send(ep, type, data, len);
+        if (ret != IPC_EFULL) {
+            return ret;
+        }
+
+        // Announce ourselves before the final check so a consumer that
+        // frees a slot right now is guaranteed to see us. It is a count, not
+        // a flag, so one MPSC producer waking up never hides the others.
+        __atomic_add_fetch(&ring->producers_waiting, 1, __ATOMIC_SEQ_CST);
+        if (ipc_ring_full(ring)) {
+            ret = ipc_syscall(IPC_OP_WAIT_SEND, ring);
+        }
+        __atomic_sub_fetch(&ring->producers_waiting, 1, __ATOMIC_SEQ_CST);
+
+        if (ret == IPC_EAGAIN) {
+            return ret;
+        }
+    }
+}
+
+int ipc_recv_wait(struct ipc_endpoint *ep, struct ipc_msg *msg) {
+    struct ipc_ring *ring = ep->rx;
+
+    for (;;) {
+        int ret = ipc_recv(ep, msg);
+        if (ret != IPC_EEMPTY) {
+            return ret;
+        }
+
+        __atomic_add_fetch(&ring->consumers_waiting, 1, __ATOMIC_SEQ_CST);
+        if (ipc_ring_empty(ring)) {
+            ret = ipc_syscall(IPC_OP_WAIT_RECV, ring);
+        }
+        __atomic_sub_fetch(&ring->consumers_waiting, 1, __ATOMIC_SEQ_CST);
+
+        if (ret == IPC_EAGAIN) {
+            return ret;
+        }
+    }
+}
+
+void ipc_handler(struct registers *regs) {
+    struct ipc_ring *ring = (struct ipc_ring *)regs->ebx;
+
+    switch (regs->eax) {
+        case IPC_OP_WAIT_RECV:
+            ring->waits++;
+            // There is no scheduler or second CPU yet, so nothing else can
+            // fill the ring while we sit here. Report it instead of halting
+            // forever; the caller re-checks the ring on IPC_OK.
+            regs->eax = ipc_ring_empty(ring) ? IPC_EAGAIN : IPC_OK;
+            break;
+
+        case IPC_OP_WAIT_SEND:
+            ring->waits++;
+            regs->eax = ipc_ring_full(ring) ? IPC_EAGAIN : IPC_OK;
+            break;
+
+        case IPC_OP_NOTIFY_RECV:
+        case IPC_OP_NOTIFY_SEND:
+            // Waiters own their counts and re-check the ring after waking,
+            // so a notify only has to reach the blocked side. With a single
+            // CPU and no blocked contexts there is nobody to wake yet.
+            ring->notifies++;
+            regs->eax = IPC_OK;
+            break;
+
+        default:
+            serial_printf("IPC: unknown operation %d\r\n", regs->eax);
+            regs->eax = IPC_EINVAL;
+            break;
+    }
+}
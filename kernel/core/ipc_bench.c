@@ -0,0 +1,152 @@
+// ipc_bench.c - IPC throughput and latency benchmark
+
+#include "../include/kernel.h"
+
+#define IPC_BENCH_MSGS   65536 // Messages per throughput run
+#define IPC_BENCH_BATCH  32    // Messages in flight per batch (half a ring)
+#define IPC_BENCH_ROUNDS 16384 // Ping-pong round trips
+#define IPC_BENCH_EDGES  1024  // Empty and full edges crossed
+
+// Read the time stamp counter
+static inline uint64_t rdtsc() {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Measure TSC ticks per millisecond using PIT channel 2 as a 10ms one-shot
+static uint32_t tsc_calibrate_khz() {
+    uint16_t count = 11932; // 1193182 Hz / 100
+
+    // Gate channel 2 on, speaker off
+    outb(0x61, (inb(0x61) & ~0x02) | 0x01);
+
+    outb(0x43, 0xB0); // Channel 2, lobyte/hibyte, mode 0 (one-shot)
+    outb(0x42, count & 0xFF);
+    outb(0x42, count >> 8);
+
+    // Restart the count by toggling the gate
+    uint8_t gate = inb(0x61) & ~0x01;
+    outb(0x61, gate);
+    outb(0x61, gate | 0x01);
+
+    uint64_t start = rdtsc();
+    while (!(inb(0x61) & 0x20)); // Wait for OUT2 to go high
+    uint32_t ticks = (uint32_t)(rdtsc() - start);
+
+    return ticks / 10;
+}
+
+// Stream messages in batches from a to b and report cycles per message
+static void ipc_bench_throughput(const char *name, int mode, uint32_t tsc_khz) {
+    struct ipc_channel chan;
+    struct ipc_msg msg;
+    uint32_t payload[4] = { 0, 1, 2, 3 };
+
+    if (ipc_channel_create(&chan, mode) != IPC_OK) {
+        serial_printf("IPC bench: out of shared pages\r\n");
+        return;
+    }
+
+    uint64_t start = rdtsc();
+    for (uint32_t sent = 0; sent < IPC_BENCH_MSGS; sent += IPC_BENCH_BATCH) {
+        for (int i = 0; i < IPC_BENCH_BATCH; i++) {
+            payload[0] = sent + i;
+            ipc_send_wait(&chan.a, 1, payload, sizeof(payload));
+        }
+        for (int i = 0; i < IPC_BENCH_BATCH; i++) {
+            ipc_recv_wait(&chan.b, &msg);
+        }
+    }
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+
+    uint32_t per_msg = cycles / IPC_BENCH_MSGS;
+    if (per_msg == 0) {
+        per_msg = 1;
+    }
+
+    serial_printf("  %s: %d cycles/msg, %d kmsg/s\r\n", name, per_msg, tsc_khz / per_msg);
+}
+
+// Bounce one message a -> b -> a and report the round-trip time
+static void ipc_bench_latency(uint32_t tsc_khz) {
+    struct ipc_channel chan;
+    struct ipc_msg msg;
+    uint32_t token = 0;
+
+    if (ipc_channel_create(&chan, IPC_MODE_SPSC) != IPC_OK) {
+        serial_printf("IPC bench: out of shared pages\r\n");
+        return;
+    }
+
+    uint64_t start = rdtsc();
+    for (int i = 0; i < IPC_BENCH_ROUNDS; i++) {
+        ipc_send_wait(&chan.a, 2, &token, sizeof(token));
+        ipc_recv_wait(&chan.b, &msg);
+        ipc_send_wait(&chan.b, 3, msg.data, msg.len);
+        ipc_recv_wait(&chan.a, &msg);
+        token++;
+    }
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+
+    uint32_t per_rtt = cycles / IPC_BENCH_ROUNDS;
+    uint32_t tsc_mhz = tsc_khz / 1000;
+    if (tsc_mhz == 0) {
+        tsc_mhz = 1;
+    }
+
+    serial_printf("  Round trip: %d cycles, %d ns\r\n", per_rtt, per_rtt * 1000 / tsc_mhz);
+}
+
+// Drive the ring onto its empty and full edges so the blocking calls have
+// to enter the kernel, and report what one of those entries costs
+static void ipc_bench_edges() {
+    struct ipc_channel chan;
+    struct ipc_msg msg;
+    uint32_t token = 0;
+    uint32_t cycles = 0;
+    int unexpected = 0;
+
+    if (ipc_channel_create(&chan, IPC_MODE_SPSC) != IPC_OK) {
+        serial_printf("IPC bench: out of shared pages\r\n");
+        return;
+    }
+
+    for (int i = 0; i < IPC_BENCH_EDGES; i++) {
+        // Empty edge: nothing queued, the receive has to ask the kernel
+        uint64_t start = rdtsc();
+        if (ipc_recv_wait(&chan.b, &msg) != IPC_EAGAIN) {
+            unexpected++;
+        }
+        cycles += (uint32_t)(rdtsc() - start);
+
+        // Full edge: fill every slot, then one more send has to ask the kernel
+        for (int j = 0; j < IPC_RING_SLOTS; j++) {
+            ipc_send(&chan.a, 4, &token, sizeof(token));
+        }
+        start = rdtsc();
+        if (ipc_send_wait(&chan.a, 4, &token, sizeof(token)) != IPC_EAGAIN) {
+            unexpected++;
+        }
+        cycles += (uint32_t)(rdtsc() - start);
+
+        // Drain back to empty for the next round
+        while (ipc_recv(&chan.b, &msg) == IPC_OK);
+    }
+
+    struct ipc_ring *ring = chan.a.tx;
+    uint32_t per_entry = ring->waits ? cycles / ring->waits : 0;
+
+    serial_printf("  Edges: %d kernel waits, %d notifies, %d cycles per wait, %d unexpected\r\n",
+                  ring->waits, ring->notifies, per_entry, unexpected);
+}
+
+void ipc_bench() {
+    uint32_t tsc_khz = tsc_calibrate_khz();
+
+    serial_printf("IPC benchmark (TSC %d kHz, both endpoints on CPU 0):\r\n", tsc_khz);
+    ipc_bench_throughput("SPSC", IPC_MODE_SPSC, tsc_khz);
+    ipc_bench_throughput("MPSC", IPC_MODE_MPSC, tsc_khz);
+    ipc_bench_latency(tsc_khz);
+    ipc_bench_edges();
+}
@@ -21,6 +21,12 @@ void start() {
     // Initialize serial port
     serial_init();
 
+    // Report how we were booted (floppy or Multiboot)
+    boot_print_info();
+
+    // Switch to the framebuffer console if stage2 or the loader set a VBE mode
+    fb_init();
+
     // Print "Hello, HssOS Kernel!" at position (0,0) with color 0x0F (white on black)
     kprintf(0, 0, 0x0F, "Hello, HssOS Kernel!");
     
@@ -33,6 +39,13 @@ void start() {
     idt_init(); // Initialize the IDT
     kprintf(0, 3, 0x0a, "IDT initialized with %d entries", 256);
 
+    ipc_init(); // Initialize IPC channels
+
+    // Benchmarks are opt-in from the kernel command line (Multiboot only)
+    if (boot_cmdline_has("bench")) {
+        ipc_bench(); // Report IPC throughput and latency on serial
+    }
+
     
     // Print various data types using kprintf
     kprintf(0, 4, 0x0F, "String: %s", "This is a string");
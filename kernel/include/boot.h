@@ -0,0 +1,71 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "kernel.h"
+
+// Stage2 (or multiboot_init) leaves a boot_info block in free low memory
+#define BOOT_INFO_ADDR  0x1000
+#define BOOT_INFO_MAGIC 0x42535348 // "HSSB"
+
+struct boot_info {
+    uint32_t magic;     // BOOT_INFO_MAGIC if a VBE mode was set
+    uint32_t fb_addr;   // Physical address of the linear framebuffer
+    uint16_t fb_pitch;  // Bytes per scanline
+    uint16_t fb_width;  // Width in pixels
+    uint16_t fb_height; // Height in pixels
+    uint8_t fb_bpp;     // Bits per pixel
+    uint8_t reserved;
+} __attribute__((packed));
+
+// What a Multiboot loader told us, copied out of loader memory
+#define BOOT_CMDLINE_MAX 256
+#define BOOT_MMAP_MAX    32
+#define BOOT_MODULES_MAX 8
+#define BOOT_NAME_MAX    64
+
+struct boot_mmap_entry {
+    uint64_t addr;
+    uint64_t len;
+    uint32_t type;      // 1 = available RAM, anything else is reserved
+};
+
+struct boot_module {
+    uint32_t start;     // Physical address of the first byte
+    uint32_t end;       // Physical address past the last byte
+    char name[BOOT_NAME_MAX];
+};
+
+extern int boot_multiboot;      // 1 if we came in through mb_entry
+extern uint32_t boot_mem_lower; // KB below 1MB
+extern uint32_t boot_mem_upper; // KB above 1MB
+extern char boot_cmdline[BOOT_CMDLINE_MAX];
+extern struct boot_mmap_entry boot_mmap[BOOT_MMAP_MAX];
+extern int boot_mmap_count;
+extern struct boot_module boot_modules[BOOT_MODULES_MAX];
+extern int boot_modules_count;
+extern uint32_t boot_modules_end; // End of the highest module, 0 if none
+
+/*
+* Checks the kernel command line for an option.
+* @param option The option to look for, matches "option" or "option=value".
+* @return 1 if present, 0 otherwise.
+* @note Always 0 on floppy boots, stage2 has no command line.
+*/
+int boot_cmdline_has(const char *option);
+
+/*
+* Reserves physical memory above the kernel image and any Multiboot modules.
+* @param size Bytes to reserve, rounded up to whole pages.
+* @return Page-aligned physical address, or 0 if the range is not available RAM.
+* @note Checked against the Multiboot memory map when we have one, stage2
+*       boots have no map and are trusted.
+*/
+uint32_t boot_reserve(uint32_t size);
+
+/*
+* Prints how we were booted (command line, memory map, modules) on serial.
+* @return None
+*/
+void boot_print_info();
+
+#endif /* BOOT_H */
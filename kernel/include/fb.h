@@ -0,0 +1,73 @@
+#ifndef FB_H
+#define FB_H
+
+#include "kernel.h"
+
+// Embedded 8x8 bitmap font covering printable ASCII
+#define FONT_WIDTH      8
+#define FONT_HEIGHT     8
+#define FONT_FIRST      0x20
+#define FONT_LAST       0x7E
+
+extern const uint8_t font8x8[FONT_LAST - FONT_FIRST + 1][FONT_HEIGHT];
+
+#define FB_MAX_ROWS     256 // Text rows we can track damage for
+#define FB_STATUS_ROWS  16  // Fixed rows for kps/kprintf, the kernel log scrolls below
+
+/*
+* Switches console output to the VBE linear framebuffer if stage2 set a mode.
+* @return None
+* @note Falls back to VGA text mode when no usable 32bpp mode is available.
+*/
+void fb_init();
+
+/*
+* Checks whether the framebuffer console is in use.
+* @return 1 if active, 0 otherwise.
+*/
+int fb_active();
+
+/*
+* Draws a string into the back buffer at a text cell position.
+* @param str The string to draw.
+* @param x The column to start at.
+* @param y The row to draw on.
+* @param color VGA attribute byte (low nibble foreground, high nibble background).
+* @return None
+* @note Only marks the cells dirty, call fb_flush() to make them visible.
+*/
+void fb_puts(const char *str, int x, int y, int color);
+
+/*
+* Writes a string at the console cursor in the log region, wrapping and
+* scrolling as needed.
+* @param str The string to write, '\n' starts a new line.
+* @param color VGA attribute byte.
+* @return None
+*/
+void fb_write(const char *str, int color);
+
+/*
+* Scrolls the log region up with a block move of the back buffer.
+* @param lines Number of text rows to scroll by.
+* @param color VGA attribute byte used for the uncovered rows.
+* @return None
+* @note fb_flush() repeats the move inside the framebuffer and only redraws
+*       the uncovered rows.
+*/
+void fb_scroll(int lines, int color);
+
+/*
+* Fills the back buffer with a background color.
+* @param color VGA attribute byte, the high nibble selects the color.
+* @return None
+*/
+void fb_clear(unsigned char color);
+
+/*
+* Copies damaged rectangles from the back buffer to the framebuffer.
+* @return None
+*/
+void fb_flush();
+
+#endif /* FB_H */
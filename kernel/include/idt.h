@@ -68,4 +68,7 @@ extern void isr29();  // Reserved
 extern void isr30();  // Reserved
 extern void isr31();  // Reserved
 
+// Declare ISR stubs for software interrupts
+extern void isr48();  // IPC wait/notify
+
 #endif /* IDT_H */
\ No newline at end of file
@@ -19,7 +19,7 @@ static inline void outb(unsigned short port, unsigned char value) {
 }
 
 /*
-* Prints a string to the screen using the VGA buffer.
+* Prints a string to the screen using the VGA buffer (or the framebuffer console).
 * @param str The string to print.
 * @param x The x coordinate of the string.
 * @param y The y coordinate of the string.
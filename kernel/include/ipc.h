@@ -0,0 +1,155 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include "kernel.h"
+
+struct registers;
+
+// Geometry of a channel. Every slot is exactly one cache line so producers
+// and consumers never false-share, and one data page holds one ring.
+#define IPC_CACHE_LINE    64
+#define IPC_PAGE_SIZE     0x1000
+#define IPC_RING_SLOTS    (IPC_PAGE_SIZE / IPC_CACHE_LINE) // 64 slots per ring
+#define IPC_MSG_MAX       52                               // Payload bytes per slot
+#define IPC_POOL_PAGES    64                               // Shared pages available to channels
+
+// Software interrupt used to enter the kernel for wait/notify
+#define IPC_VECTOR        0x30
+
+// Ring producer modes
+#define IPC_MODE_SPSC     0 // Single producer, single consumer
+#define IPC_MODE_MPSC     1 // Multiple producers, single consumer
+
+// Operations passed in EAX to the IPC vector
+#define IPC_OP_WAIT_RECV   1 // Block until the ring is non-empty
+#define IPC_OP_WAIT_SEND   2 // Block until the ring is non-full
+#define IPC_OP_NOTIFY_RECV 3 // Wake the consumer blocked on an empty ring
+#define IPC_OP_NOTIFY_SEND 4 // Wake the producers blocked on a full ring
+
+// Return codes
+#define IPC_OK            0
+#define IPC_EEMPTY       -1
+#define IPC_EFULL        -2
+#define IPC_EINVAL       -3
+#define IPC_ENOMEM       -4
+#define IPC_EAGAIN       -5 // Would block with nothing else able to make progress
+
+// One message slot (one cache line)
+struct ipc_slot {
+    volatile uint32_t seq;  // Sequence number, tells producers/consumers who owns the slot
+    uint32_t type;          // User-defined message type
+    uint32_t len;           // Payload length in bytes
+    uint8_t data[IPC_MSG_MAX];
+} __attribute__((aligned(IPC_CACHE_LINE)));
+
+// Ring control block. Producer and consumer state live on separate cache
+// lines, and the waiter counts both sides poll after every message get a
+// line of their own that is only written on the slow path. The fast path
+// writes only the line it owns plus the slot, everything else it touches
+// stays shared in both caches.
+struct ipc_ring {
+    // Producer line
+    volatile uint32_t head;             // Next slot to claim
+    uint32_t mode;                      // IPC_MODE_SPSC or IPC_MODE_MPSC
+    uint8_t pad0[IPC_CACHE_LINE - 8];
+
+    // Consumer line
+    volatile uint32_t tail;             // Next slot to consume
+    uint8_t pad1[IPC_CACHE_LINE - 4];
+
+    // Waiter line (only written when an endpoint blocks or wakes)
+    volatile uint32_t producers_waiting; // Producers blocked on a full ring
+    volatile uint32_t consumers_waiting; // Consumers blocked on an empty ring
+    uint8_t pad2[IPC_CACHE_LINE - 8];
+
+    // Kernel statistics line (only written inside the kernel)
+    volatile uint32_t waits;            // Times an endpoint entered the kernel to block
+    volatile uint32_t notifies;         // Times an endpoint entered the kernel to wake a peer
+    uint8_t pad3[IPC_CACHE_LINE - 8];
+
+    struct ipc_slot *slots;             // Data page holding IPC_RING_SLOTS slots
+} __attribute__((aligned(IPC_CACHE_LINE)));
+
+// One side of a channel: sends on tx, receives on rx
+struct ipc_endpoint {
+    struct ipc_ring *tx;
+    struct ipc_ring *rx;
+};
+
+// A bidirectional channel backed by shared pages: one control page holding
+// both ring headers and one data page per direction.
+struct ipc_channel {
+    struct ipc_endpoint a;
+    struct ipc_endpoint b;
+};
+
+// Message as seen by a receiver
+struct ipc_msg {
+    uint32_t type;
+    uint32_t len;
+    uint8_t data[IPC_MSG_MAX];
+};
+
+/*
+* Initializes the shared page pool and installs the IPC interrupt gate.
+* @return None
+* @note Must be called after idt_init().
+*/
+void ipc_init();
+
+/*
+* Creates a channel from pages in the shared pool.
+* @param chan The channel to fill in.
+* @param mode IPC_MODE_SPSC or IPC_MODE_MPSC, applied to both directions.
+* @return IPC_OK, IPC_EINVAL or IPC_ENOMEM.
+*/
+int ipc_channel_create(struct ipc_channel *chan, int mode);
+
+/*
+* Sends a message without blocking.
+* @param ep The sending endpoint.
+* @param type User-defined message type.
+* @param data Payload to copy into the ring.
+* @param len Payload length, at most IPC_MSG_MAX.
+* @return IPC_OK, IPC_EFULL or IPC_EINVAL.
+*/
+int ipc_send(struct ipc_endpoint *ep, uint32_t type, const void *data, uint32_t len);
+
+/*
+* Receives a message without blocking.
+* @param ep The receiving endpoint.
+* @param msg Where to copy the message.
+* @return IPC_OK, IPC_EEMPTY or IPC_EINVAL (oversized message, dropped).
+*/
+int ipc_recv(struct ipc_endpoint *ep, struct ipc_msg *msg);
+
+/*
+* Sends a message, entering the kernel to block only if the ring is full.
+* @return IPC_OK, IPC_EINVAL or IPC_EAGAIN.
+* @note Until there is a scheduler or a second CPU, nothing can drain the
+*       ring while we block, so the kernel returns IPC_EAGAIN instead.
+*/
+int ipc_send_wait(struct ipc_endpoint *ep, uint32_t type, const void *data, uint32_t len);
+
+/*
+* Receives a message, entering the kernel to block only if the ring is empty.
+* @return IPC_OK, IPC_EINVAL or IPC_EAGAIN (see ipc_send_wait).
+*/
+int ipc_recv_wait(struct ipc_endpoint *ep, struct ipc_msg *msg);
+
+/*
+* Kernel side of the IPC vector, called from isr_handler.
+* @param regs The saved registers; EAX holds the operation, EBX the ring.
+*             The result is returned to the caller in EAX.
+* @return None
+*/
+void ipc_handler(struct registers *regs);
+
+/*
+* Measures throughput and round-trip latency over a channel and reports
+* the results on the serial console.
+* @return None
+*/
+void ipc_bench();
+
+#endif /* IPC_H */
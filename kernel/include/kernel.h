@@ -10,6 +10,10 @@ typedef unsigned long long uint64_t;
 // Include all kernel subsystem headers
 #include "io.h"
 #include "idt.h"
+#include "ipc.h"
+#include "boot.h"
+#include "multiboot.h"
+#include "fb.h"
 
 // VGA text mode colors
 enum vga_color {
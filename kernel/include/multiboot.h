@@ -0,0 +1,78 @@
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+#include "kernel.h"
+
+// Value in EAX when a Multiboot loader jumps to mb_entry
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+
+// multiboot_info.flags bits
+#define MULTIBOOT_INFO_MEMORY      (1 << 0)  // mem_lower/mem_upper valid
+#define MULTIBOOT_INFO_CMDLINE     (1 << 2)  // cmdline valid
+#define MULTIBOOT_INFO_MODS        (1 << 3)  // mods_count/mods_addr valid
+#define MULTIBOOT_INFO_MEM_MAP     (1 << 6)  // mmap_length/mmap_addr valid
+#define MULTIBOOT_INFO_LOADER_NAME (1 << 9)  // boot_loader_name valid
+#define MULTIBOOT_INFO_FRAMEBUFFER (1 << 12) // framebuffer_* valid
+
+#define MULTIBOOT_FRAMEBUFFER_RGB  1
+
+// Memory map entry types
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+// Multiboot information structure (Multiboot 0.6.96, section 3.3)
+struct multiboot_info {
+    uint32_t flags;
+    uint32_t mem_lower;           // KB of memory below 1MB
+    uint32_t mem_upper;           // KB of memory above 1MB
+    uint32_t boot_device;
+    uint32_t cmdline;             // Physical address of the command line
+    uint32_t mods_count;
+    uint32_t mods_addr;           // Physical address of multiboot_module[]
+    uint32_t syms[4];
+    uint32_t mmap_length;         // Size of the memory map buffer in bytes
+    uint32_t mmap_addr;           // Physical address of the memory map
+    uint32_t drives_length;
+    uint32_t drives_addr;
+    uint32_t config_table;
+    uint32_t boot_loader_name;
+    uint32_t apm_table;
+    uint32_t vbe_control_info;
+    uint32_t vbe_mode_info;
+    uint16_t vbe_mode;
+    uint16_t vbe_interface_seg;
+    uint16_t vbe_interface_off;
+    uint16_t vbe_interface_len;
+    uint64_t framebuffer_addr;
+    uint32_t framebuffer_pitch;
+    uint32_t framebuffer_width;
+    uint32_t framebuffer_height;
+    uint8_t framebuffer_bpp;
+    uint8_t framebuffer_type;
+} __attribute__((packed));
+
+// Memory map entry, size does not include the size field itself
+struct multiboot_mmap_entry {
+    uint32_t size;
+    uint64_t addr;
+    uint64_t len;
+    uint32_t type;
+} __attribute__((packed));
+
+// Boot module descriptor
+struct multiboot_module {
+    uint32_t mod_start;
+    uint32_t mod_end;
+    uint32_t string;              // Physical address of the module command line
+    uint32_t reserved;
+} __attribute__((packed));
+
+/*
+* Copies the Multiboot information into kernel memory.
+* @param magic The value the loader left in EAX.
+* @param mbi The multiboot_info the loader left in EBX.
+* @return None
+* @note Called by mb_entry before start(), serial output is not up yet.
+*/
+void multiboot_init(uint32_t magic, struct multiboot_info *mbi);
+
+#endif /* MULTIBOOT_H */